@@ -8,9 +8,15 @@
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <vector>
 
 double getInputWithDefault(const std::string& prompt, double defaultValue) {
     std::string input;
@@ -33,7 +39,61 @@ double getInputWithDefault(const std::string& prompt, double defaultValue) {
     }
 }
 
+// Fill coords[periodSize, numPoints) with copies of the first periodSize points,
+// shifting copy k by k * offset. Chunks copy contiguous runs of the period so
+// the inner loop is a plain add the compiler can vectorize.
+void replicatePeriod(double* coords, vtkIdType periodSize, vtkIdType numPoints, const double offset[3])
+{
+    vtkSMPTools::For(periodSize, numPoints, [&](vtkIdType i0, vtkIdType i1) {
+        for (vtkIdType i = i0; i < i1;)
+        {
+            vtkIdType period = i / periodSize;
+            vtkIdType j = i - period * periodSize;
+            vtkIdType run = std::min(periodSize - j, i1 - i);
+            const double shift[3] = { period * offset[0], period * offset[1], period * offset[2] };
+            const double* src = coords + 3 * j;
+            double* dst = coords + 3 * i;
+            for (vtkIdType n = 0; n < 3 * run; n += 3)
+            {
+                dst[n] = src[n] + shift[0];
+                dst[n + 1] = src[n + 1] + shift[1];
+                dst[n + 2] = src[n + 2] + shift[2];
+            }
+            i += run;
+        }
+    });
+}
 
+// Wall-clock time of a call in seconds
+template <typename F>
+double secondsToRun(const F& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Best wall-clock time of several calls in seconds, so a cold first call does
+// not skew the benchmark
+template <typename F>
+double bestSecondsToRun(const F& f, int runs = 5)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < runs; run++)
+    {
+        best = std::min(best, secondsToRun(f));
+    }
+    return best;
+}
+
+// Print how replicating one period compares to evaluating every point
+void printBenchmark(const char* label, double evaluateSeconds, double replicateSeconds, vtkIdType numPoints)
+{
+    double bytes = 2.0 * 3 * sizeof(double) * numPoints;
+    std::cout << label << ": evaluate every point " << evaluateSeconds << " s, replicate one period "
+              << replicateSeconds << " s, " << bytes / replicateSeconds / 1e9 << " GB/s copied, "
+              << evaluateSeconds / replicateSeconds << "x speedup\n";
+}
 
 int main()
 {
@@ -49,20 +109,106 @@ int main()
     endDeg = getInputWithDefault("Enter end degree (360 by default): ", endDeg);
 
     // Number of points for smooth sine wave
-    const unsigned int numPoints = 1000;
-
-    // Create a vtkPoints object to store the sine wave points
-    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    double numPointsInput = getInputWithDefault("Enter number of points (1000 by default): ", 1000.0);
+    if (!(numPointsInput >= 2.0))
+    {
+        std::cerr << "At least 2 points are needed. Using default value 1000.\n";
+        numPointsInput = 1000.0;
+    }
+    unsigned int numPoints = static_cast<unsigned int>(
+        std::min(numPointsInput, static_cast<double>(std::numeric_limits<unsigned int>::max())));
+    bool replicate = getInputWithDefault("Replicate one period, 1 = yes, 0 = no (0 by default): ", 0.0) != 0.0;
+    bool benchmark = getInputWithDefault("Run generation benchmark, 1 = yes, 0 = no (0 by default): ", 0.0) != 0.0;
 
     // Calculate points
     double startRad = vtkMath::RadiansFromDegrees(startDeg);
     double endRad = vtkMath::RadiansFromDegrees(endDeg);
     double step = (endRad - startRad) / (numPoints - 1);
 
-    for (unsigned int i = 0; i < numPoints; i++)
+    // Replication needs an increasing range and a whole number of points per
+    // period, so snap the step to it; the end of the range may move by less
+    // than one step. Below 4 points per period the wave is undersampled and
+    // snapping would change the point count arbitrarily, so it is not offered
+    const double period = 2.0 * vtkMath::Pi();
+    const int minPointsPerPeriod = 4;
+    bool canReplicate = step > 0.0 && step <= period / minPointsPerPeriod;
+    vtkIdType pointsPerPeriod = canReplicate ? std::lround(period / step) : 0;
+    double snappedStep = canReplicate ? period / pointsPerPeriod : step;
+    double numSnappedInput = canReplicate ? std::floor((endRad - startRad) / snappedStep + 1e-9) + 1.0 : numPoints;
+    canReplicate = canReplicate && numSnappedInput <= std::numeric_limits<unsigned int>::max();
+    unsigned int numSnappedPoints = canReplicate ? std::max(2u, static_cast<unsigned int>(numSnappedInput)) : numPoints;
+    if (replicate && !canReplicate)
+    {
+        std::cerr << "Replication needs the end degree above the start degree and at least "
+                  << minPointsPerPeriod << " points per period. Evaluating every point.\n";
+    }
+    replicate = replicate && canReplicate;
+    if (replicate)
+    {
+        if (numSnappedPoints != numPoints)
+        {
+            std::cout << "Replication snapped the step from " << step << " to " << snappedStep
+                      << " rad and the number of points from " << numPoints << " to " << numSnappedPoints << ".\n";
+        }
+        step = snappedStep;
+        numPoints = numSnappedPoints;
+    }
+
+    // Evaluate count points of the wave starting at startRad
+    auto evaluate = [startRad](double* coords, vtkIdType count, double step) {
+        vtkSMPTools::For(0, count, [&](vtkIdType i0, vtkIdType i1) {
+            for (vtkIdType i = i0; i < i1; i++)
+            {
+                double x = startRad + i * step;
+                coords[3 * i] = x;
+                coords[3 * i + 1] = std::sin(x);
+                coords[3 * i + 2] = 0.0;
+            }
+        });
+    };
+
+    // Evaluate one period and copy it, shifted by the period along X, over the rest
+    const double periodOffset[3] = { period, 0.0, 0.0 };
+    auto evaluateReplicated = [&](double* coords, vtkIdType count) {
+        evaluate(coords, std::min(pointsPerPeriod, count), snappedStep);
+        replicatePeriod(coords, pointsPerPeriod, count, periodOffset);
+    };
+
+    // Create a vtkPoints object to store the sine wave points
+    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numPoints);
+    double* coords = static_cast<double*>(points->GetVoidPointer(0));
+
+    double seconds = secondsToRun([&]() {
+        if (replicate)
+        {
+            evaluateReplicated(coords, numPoints);
+        }
+        else
+        {
+            evaluate(coords, numPoints, step);
+        }
+    });
+    std::cout << "Generated " << numPoints << " points in " << seconds << " s using "
+              << vtkSMPTools::GetEstimatedNumberOfThreads() << " threads\n";
+
+    if (benchmark)
     {
-        double x = startRad + i * step;
-        points->InsertNextPoint(x, std::sin(x), 0.0);
+        // Both timings use the snapped step so they produce the same points
+        if (canReplicate)
+        {
+            std::vector<double> scratch(3 * static_cast<size_t>(numSnappedPoints));
+            printBenchmark("Sine wave",
+                bestSecondsToRun([&]() { evaluate(scratch.data(), numSnappedPoints, snappedStep); }),
+                bestSecondsToRun([&]() { evaluateReplicated(scratch.data(), numSnappedPoints); }),
+                numSnappedPoints);
+        }
+        else
+        {
+            std::cout << "Benchmark skipped: replication needs the end degree above the start degree and at least "
+                      << minPointsPerPeriod << " points per period.\n";
+        }
     }
 
     // Create a cell array to store the lines in and add the lines
@@ -9,11 +9,18 @@
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkMath.h>
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <limits>
+#include <memory>
 #include <cmath>
 #include <sstream>
+#include <numeric>
+#include <vector>
 
 // Function to get input with a default value
 template <typename T>
@@ -30,24 +37,163 @@ T getInputWithDefault(const std::string& prompt, T defaultValue) {
     return stream.fail() ? defaultValue : value;
 }
 
+// Resample a parametric curve at numPoints points evenly spaced in arc length.
+// The cumulative chord length over numDense uniform t samples is built with a
+// blocked parallel prefix sum, inverted for each output point, and the curve is
+// re-evaluated at the resulting t values.
+template <typename Curve>
+void resampleByArcLength(const Curve& curve, double tStart, double tEnd,
+                         vtkIdType numDense, vtkIdType numPoints, double* out) {
+    // Both the dense samples and the output need at least one segment
+    if (numDense < 2 || numPoints < 2) {
+        return;
+    }
+
+    const vtkIdType numSegments = numDense - 1;
+    const double dt = (tEnd - tStart) / numSegments;
+
+    // Pass 1: each block scans its own segment lengths
+    // Left uninitialised so the pages are first touched by the parallel scan
+    std::unique_ptr<double[]> cumulative(new double[numDense]);
+    cumulative[0] = 0.0;
+    const vtkIdType numBlocks = std::min<vtkIdType>(numSegments, 64 * vtkSMPTools::GetEstimatedNumberOfThreads());
+    const vtkIdType blockSize = (numSegments + numBlocks - 1) / numBlocks;
+    std::vector<double> blockOffsets(numBlocks + 1, 0.0);
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType b0, vtkIdType b1) {
+        for (vtkIdType b = b0; b < b1; ++b) {
+            vtkIdType first = b * blockSize;
+            vtkIdType last = std::min(first + blockSize, numSegments);
+            double p[3], q[3];
+            curve(tStart + first * dt, p);
+            double sum = 0.0;
+            for (vtkIdType k = first; k < last; ++k) {
+                curve(tStart + (k + 1) * dt, q);
+                sum += std::sqrt(vtkMath::Distance2BetweenPoints(p, q));
+                cumulative[k + 1] = sum;
+                std::copy(q, q + 3, p);
+            }
+            blockOffsets[b + 1] = sum;
+        }
+    });
+
+    // Pass 2: scan the block totals, then shift every block by its offset
+    std::partial_sum(blockOffsets.begin(), blockOffsets.end(), blockOffsets.begin());
+    vtkSMPTools::For(1, numBlocks, [&](vtkIdType b0, vtkIdType b1) {
+        for (vtkIdType b = b0; b < b1; ++b) {
+            vtkIdType first = b * blockSize;
+            vtkIdType last = std::min(first + blockSize, numSegments);
+            for (vtkIdType k = first; k < last; ++k) {
+                cumulative[k + 1] += blockOffsets[b];
+            }
+        }
+    });
+
+    // Invert s(t): targets are sorted, so each chunk does one binary search
+    // and then walks forward through the cumulative lengths
+    const double totalLength = cumulative[numSegments];
+    const double ds = totalLength / (numPoints - 1);
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType i0, vtkIdType i1) {
+        auto it = std::upper_bound(cumulative.get(), cumulative.get() + numDense, i0 * ds);
+        vtkIdType k = std::min<vtkIdType>(std::max<vtkIdType>((it - cumulative.get()) - 1, 0), numSegments - 1);
+        for (vtkIdType i = i0; i < i1; ++i) {
+            double s = std::min(i * ds, totalLength);
+            while (k < numSegments - 1 && cumulative[k + 1] < s) {
+                ++k;
+            }
+            double segment = cumulative[k + 1] - cumulative[k];
+            double fraction = segment > 0.0 ? (s - cumulative[k]) / segment : 0.0;
+            curve(tStart + (k + fraction) * dt, out + 3 * i);
+        }
+    });
+}
+
+// Spacing statistics between consecutive points, accumulated per thread
+struct SpacingStats {
+    double minLength = std::numeric_limits<double>::max();
+    double maxLength = 0.0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+};
+
+// Print how far the spacing of a polyline deviates from uniform
+void printSpacingReport(const double* coords, vtkIdType numPoints) {
+    if (numPoints < 2) {
+        return;
+    }
+
+    vtkSMPThreadLocal<SpacingStats> localStats;
+    vtkSMPTools::For(1, numPoints, [&](vtkIdType i0, vtkIdType i1) {
+        SpacingStats& stats = localStats.Local();
+        for (vtkIdType i = i0; i < i1; ++i) {
+            double length = std::sqrt(vtkMath::Distance2BetweenPoints(coords + 3 * (i - 1), coords + 3 * i));
+            stats.minLength = std::min(stats.minLength, length);
+            stats.maxLength = std::max(stats.maxLength, length);
+            stats.sum += length;
+            stats.sumSquares += length * length;
+        }
+    });
+
+    SpacingStats total;
+    for (const SpacingStats& stats : localStats) {
+        total.minLength = std::min(total.minLength, stats.minLength);
+        total.maxLength = std::max(total.maxLength, stats.maxLength);
+        total.sum += stats.sum;
+        total.sumSquares += stats.sumSquares;
+    }
+
+    const double numSegments = static_cast<double>(numPoints - 1);
+    const double mean = total.sum / numSegments;
+    const double variance = std::max(0.0, total.sumSquares / numSegments - mean * mean);
+    std::cout << "Segment length: mean " << mean
+              << ", min " << total.minLength
+              << ", max " << total.maxLength << "\n";
+    std::cout << "Max deviation from uniform: "
+              << 100.0 * std::max(total.maxLength - mean, mean - total.minLength) / mean
+              << "%, coefficient of variation: " << 100.0 * std::sqrt(variance) / mean << "%\n";
+}
+
 int main() {
     // User input for the range of t and number of points
     double tStart = getInputWithDefault("Enter start value for t", 0.0);
     double tEnd = getInputWithDefault("Enter end value for t", 2.0 * vtkMath::Pi());
     int numPoints = getInputWithDefault("Enter number of points", 500);
+    if (numPoints < 2) {
+        std::cerr << "At least 2 points are needed. Using default value 500.\n";
+        numPoints = 500;
+    }
+    int resample = getInputWithDefault("Resample to uniform arc length (1 = yes, 0 = no)", 1);
+    int oversampling = getInputWithDefault("Enter arc length oversampling factor", 4);
+
+    // Trefoil knot as a function of t
+    auto trefoil = [](double t, double p[3]) {
+        p[0] = std::sin(t) + 2 * std::sin(2 * t);
+        p[1] = std::cos(t) - 2 * std::cos(2 * t);
+        p[2] = -std::sin(3 * t);
+    };
 
     // Create a vtkPoints object to store the curve points
     vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numPoints);
+    double* coords = static_cast<double*>(points->GetVoidPointer(0));
 
-    // Calculate points
-    double step = (tEnd - tStart) / (numPoints - 1);
-    for (int i = 0; i < numPoints; ++i) {
-        double t = tStart + i * step;
-        double x = std::sin(t) + 2 * std::sin(2 * t);
-        double y = std::cos(t) - 2 * std::cos(2 * t);
-        double z = -std::sin(3 * t);
-        points->InsertNextPoint(x, y, z);
+    // Calculate points, either at uniform t or at uniform arc length
+    auto startTime = std::chrono::steady_clock::now();
+    if (resample) {
+        vtkIdType numDense = static_cast<vtkIdType>(numPoints) * std::max(oversampling, 1);
+        resampleByArcLength(trefoil, tStart, tEnd, numDense, numPoints, coords);
+    } else {
+        double step = (tEnd - tStart) / (numPoints - 1);
+        vtkSMPTools::For(0, numPoints, [&](vtkIdType i0, vtkIdType i1) {
+            for (vtkIdType i = i0; i < i1; ++i) {
+                trefoil(tStart + i * step, coords + 3 * i);
+            }
+        });
     }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    std::cout << "Generated " << numPoints << " points in " << elapsed.count() << " s using "
+              << vtkSMPTools::GetEstimatedNumberOfThreads() << " threads\n";
+    printSpacingReport(coords, numPoints);
 
     // Create a cell array to store the lines
     vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
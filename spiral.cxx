@@ -4,13 +4,23 @@
 #include <vtkCellArray.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataMapper.h>
+#include <vtkGlyph3DMapper.h>
 #include <vtkActor.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 #include <vtkRenderWindowInteractor.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
 
 double getInputWithDefault(const std::string& prompt, double defaultValue) {
     std::string input;
@@ -33,6 +43,189 @@ double getInputWithDefault(const std::string& prompt, double defaultValue) {
     }
 }
 
+// Resample a parametric curve at numPoints points evenly spaced in arc length.
+// The cumulative chord length over numDense uniform t samples is built with a
+// blocked parallel prefix sum, inverted for each output point, and the curve is
+// re-evaluated at the resulting t values.
+template <typename Curve>
+void resampleByArcLength(const Curve& curve, double tStart, double tEnd,
+                         vtkIdType numDense, vtkIdType numPoints, double* out)
+{
+    // Both the dense samples and the output need at least one segment
+    if (numDense < 2 || numPoints < 2)
+    {
+        return;
+    }
+
+    const vtkIdType numSegments = numDense - 1;
+    const double dt = (tEnd - tStart) / numSegments;
+
+    // Pass 1: each block scans its own segment lengths
+    // Left uninitialised so the pages are first touched by the parallel scan
+    std::unique_ptr<double[]> cumulative(new double[numDense]);
+    cumulative[0] = 0.0;
+    const vtkIdType numBlocks = std::min<vtkIdType>(numSegments, 64 * vtkSMPTools::GetEstimatedNumberOfThreads());
+    const vtkIdType blockSize = (numSegments + numBlocks - 1) / numBlocks;
+    std::vector<double> blockOffsets(numBlocks + 1, 0.0);
+    vtkSMPTools::For(0, numBlocks, [&](vtkIdType b0, vtkIdType b1) {
+        for (vtkIdType b = b0; b < b1; ++b)
+        {
+            vtkIdType first = b * blockSize;
+            vtkIdType last = std::min(first + blockSize, numSegments);
+            double p[3], q[3];
+            curve(tStart + first * dt, p);
+            double sum = 0.0;
+            for (vtkIdType k = first; k < last; ++k)
+            {
+                curve(tStart + (k + 1) * dt, q);
+                sum += std::sqrt(vtkMath::Distance2BetweenPoints(p, q));
+                cumulative[k + 1] = sum;
+                std::copy(q, q + 3, p);
+            }
+            blockOffsets[b + 1] = sum;
+        }
+    });
+
+    // Pass 2: scan the block totals, then shift every block by its offset
+    std::partial_sum(blockOffsets.begin(), blockOffsets.end(), blockOffsets.begin());
+    vtkSMPTools::For(1, numBlocks, [&](vtkIdType b0, vtkIdType b1) {
+        for (vtkIdType b = b0; b < b1; ++b)
+        {
+            vtkIdType first = b * blockSize;
+            vtkIdType last = std::min(first + blockSize, numSegments);
+            for (vtkIdType k = first; k < last; ++k)
+            {
+                cumulative[k + 1] += blockOffsets[b];
+            }
+        }
+    });
+
+    // Invert s(t): targets are sorted, so each chunk does one binary search
+    // and then walks forward through the cumulative lengths
+    const double totalLength = cumulative[numSegments];
+    const double ds = totalLength / (numPoints - 1);
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType i0, vtkIdType i1) {
+        auto it = std::upper_bound(cumulative.get(), cumulative.get() + numDense, i0 * ds);
+        vtkIdType k = std::min<vtkIdType>(std::max<vtkIdType>((it - cumulative.get()) - 1, 0), numSegments - 1);
+        for (vtkIdType i = i0; i < i1; ++i)
+        {
+            double s = std::min(i * ds, totalLength);
+            while (k < numSegments - 1 && cumulative[k + 1] < s)
+            {
+                ++k;
+            }
+            double segment = cumulative[k + 1] - cumulative[k];
+            double fraction = segment > 0.0 ? (s - cumulative[k]) / segment : 0.0;
+            curve(tStart + (k + fraction) * dt, out + 3 * i);
+        }
+    });
+}
+
+// Spacing statistics between consecutive points, accumulated per thread
+struct SpacingStats
+{
+    double minLength = std::numeric_limits<double>::max();
+    double maxLength = 0.0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+};
+
+// Print how far the spacing of a polyline deviates from uniform
+void printSpacingReport(const double* coords, vtkIdType numPoints)
+{
+    if (numPoints < 2)
+    {
+        return;
+    }
+
+    vtkSMPThreadLocal<SpacingStats> localStats;
+    vtkSMPTools::For(1, numPoints, [&](vtkIdType i0, vtkIdType i1) {
+        SpacingStats& stats = localStats.Local();
+        for (vtkIdType i = i0; i < i1; ++i)
+        {
+            double length = std::sqrt(vtkMath::Distance2BetweenPoints(coords + 3 * (i - 1), coords + 3 * i));
+            stats.minLength = std::min(stats.minLength, length);
+            stats.maxLength = std::max(stats.maxLength, length);
+            stats.sum += length;
+            stats.sumSquares += length * length;
+        }
+    });
+
+    SpacingStats total;
+    for (const SpacingStats& stats : localStats)
+    {
+        total.minLength = std::min(total.minLength, stats.minLength);
+        total.maxLength = std::max(total.maxLength, stats.maxLength);
+        total.sum += stats.sum;
+        total.sumSquares += stats.sumSquares;
+    }
+
+    const double numSegments = static_cast<double>(numPoints - 1);
+    const double mean = total.sum / numSegments;
+    const double variance = std::max(0.0, total.sumSquares / numSegments - mean * mean);
+    std::cout << "Segment length: mean " << mean
+              << ", min " << total.minLength
+              << ", max " << total.maxLength << "\n";
+    std::cout << "Max deviation from uniform: "
+              << 100.0 * std::max(total.maxLength - mean, mean - total.minLength) / mean
+              << "%, coefficient of variation: " << 100.0 * std::sqrt(variance) / mean << "%\n";
+}
+
+// Fill coords[periodSize, numPoints) with copies of the first periodSize points,
+// shifting copy k by k * offset. Chunks copy contiguous runs of the period so
+// the inner loop is a plain add the compiler can vectorize.
+void replicatePeriod(double* coords, vtkIdType periodSize, vtkIdType numPoints, const double offset[3])
+{
+    vtkSMPTools::For(periodSize, numPoints, [&](vtkIdType i0, vtkIdType i1) {
+        for (vtkIdType i = i0; i < i1;)
+        {
+            vtkIdType period = i / periodSize;
+            vtkIdType j = i - period * periodSize;
+            vtkIdType run = std::min(periodSize - j, i1 - i);
+            const double shift[3] = { period * offset[0], period * offset[1], period * offset[2] };
+            const double* src = coords + 3 * j;
+            double* dst = coords + 3 * i;
+            for (vtkIdType n = 0; n < 3 * run; n += 3)
+            {
+                dst[n] = src[n] + shift[0];
+                dst[n + 1] = src[n + 1] + shift[1];
+                dst[n + 2] = src[n + 2] + shift[2];
+            }
+            i += run;
+        }
+    });
+}
+
+// Wall-clock time of a call in seconds
+template <typename F>
+double secondsToRun(const F& f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Best wall-clock time of several calls in seconds, so a cold first call does
+// not skew the benchmark
+template <typename F>
+double bestSecondsToRun(const F& f, int runs = 5)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int run = 0; run < runs; run++)
+    {
+        best = std::min(best, secondsToRun(f));
+    }
+    return best;
+}
+
+// Print how replicating one period compares to evaluating every point
+void printBenchmark(const char* label, double evaluateSeconds, double replicateSeconds, vtkIdType numPoints)
+{
+    double bytes = 2.0 * 3 * sizeof(double) * numPoints;
+    std::cout << label << ": evaluate every point " << evaluateSeconds << " s, replicate one period "
+              << replicateSeconds << " s, " << bytes / replicateSeconds / 1e9 << " GB/s copied, "
+              << evaluateSeconds / replicateSeconds << "x speedup\n";
+}
 
 int main()
 {
@@ -51,30 +244,129 @@ int main()
 	
 	 pitch = getInputWithDefault("Enter pitch of the spiral (default 1.0): ", pitch);
 	 radius = getInputWithDefault("Enter radius of the spiral (default 5.0): ", radius);
-	 turns = getInputWithDefault("Enter number of turns (default 5): ", turns);
+	 double turnsInput = getInputWithDefault("Enter number of turns (default 5): ", turns);
+	 if (!(turnsInput >= 1.0))
+	 {
+		 std::cerr << "At least 1 turn is needed. Using default value " << turns << ".\n";
+		 turnsInput = turns;
+	 }
+	 turns = static_cast<unsigned int>(
+		 std::min(turnsInput, static_cast<double>(std::numeric_limits<unsigned int>::max())));
+	 // The helix has constant speed, so uniform angle is already uniform arc length
+	 bool resample = getInputWithDefault("Resample to uniform arc length, 1 = yes, 0 = no (default 0): ", 0.0) != 0.0;
+	 int oversampling = 4;
+	 if (resample)
+	 {
+		 double oversamplingInput = getInputWithDefault("Enter arc length oversampling factor (default 4): ", oversampling);
+		 oversampling = static_cast<int>(std::min(std::max(oversamplingInput, 1.0), 64.0));
+	 }
+	 double modeInput = getInputWithDefault(
+		 "Generation mode, 0 = evaluate every point, 1 = replicate one turn, "
+		 "2 = instance one closed turn, ending on a whole turn (default 1): ", 1.0);
+	 if (modeInput != 0.0 && modeInput != 1.0 && modeInput != 2.0)
+	 {
+		 std::cerr << "Generation mode must be 0, 1 or 2. Using default value 1.\n";
+		 modeInput = 1.0;
+	 }
+	 int mode = static_cast<int>(modeInput);
+	 bool benchmark = getInputWithDefault("Run generation benchmark, 1 = yes, 0 = no (default 0): ", 0.0) != 0.0;
 	
 	
 
     // Total number of points
-    unsigned int numPoints = numPointsPerTurn * turns;
+    vtkIdType numPoints = static_cast<vtkIdType>(numPointsPerTurn) * turns;
+
+    // Spiral as a function of the angle in radians; Z increases with pitch
+    auto spiral = [pitch, radius](double angle, double p[3])
+    {
+        p[0] = radius * std::cos(angle);                   // X-coordinate
+        p[1] = radius * std::sin(angle);                   // Y-coordinate
+        p[2] = pitch * angle / (2.0 * vtkMath::Pi());      // Z-coordinate
+    };
+
+    // Calculate the first count points of the spiral at uniform angle
+    double angleStep = 2.0 * vtkMath::Pi() / numPointsPerTurn;
+    auto evaluateUniform = [&](double* coords, vtkIdType count) {
+        vtkSMPTools::For(0, count, [&](vtkIdType i0, vtkIdType i1) {
+            for (vtkIdType i = i0; i < i1; i++)
+            {
+                spiral(angleStep * i, coords + 3 * i);
+            }
+        });
+    };
+
+    // Calculate the first count points, optionally at uniform arc length
+    auto evaluate = [&](double* coords, vtkIdType count) {
+        if (resample)
+        {
+            resampleByArcLength(spiral, 0.0, angleStep * (count - 1), oversampling * count, count, coords);
+        }
+        else
+        {
+            evaluateUniform(coords, count);
+        }
+    };
+
+    // Turn k equals turn 0 moved up by k * pitch, so evaluate one turn and copy it
+    const double turnOffset[3] = { 0.0, 0.0, pitch };
+    auto evaluateReplicated = [&](double* coords, vtkIdType count) {
+        evaluate(coords, std::min<vtkIdType>(numPointsPerTurn, count));
+        replicatePeriod(coords, numPointsPerTurn, count, turnOffset);
+    };
+
+    // When instancing, store a single closed turn and draw it once per turn.
+    // Consecutive instances share their seam point, and the last one ends at
+    // 2 * pi * turns rather than one step before it
+    bool instance = mode == 2 && turns > 1;
+    vtkIdType numStored = instance ? numPointsPerTurn + 1 : numPoints;
 
     // Create a vtkPoints object to store the spiral points
     vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataTypeToDouble();
+    points->SetNumberOfPoints(numStored);
+    double* coords = static_cast<double*>(points->GetVoidPointer(0));
+
+    double seconds = secondsToRun([&]() {
+        if (mode == 1)
+        {
+            evaluateReplicated(coords, numStored);
+        }
+        else
+        {
+            evaluate(coords, numStored);
+        }
+    });
+    std::cout << "Generated " << numStored << " points in " << seconds << " s using "
+              << vtkSMPTools::GetEstimatedNumberOfThreads() << " threads\n";
+    printSpacingReport(coords, numStored);
 
-    // Calculate points for the spiral
-    for (unsigned int i = 0; i < numPoints; i++)
+    if (benchmark)
     {
-        double angle = 2.0 * vtkMath::Pi() * i / numPointsPerTurn; // Angle in radians
-        double z = pitch * i / numPointsPerTurn;                  // Z increases with pitch
-        double x = radius * std::cos(angle);                     // X-coordinate
-        double y = radius * std::sin(angle);                     // Y-coordinate
+        std::vector<double> scratch(3 * static_cast<size_t>(numPoints));
+        double* data = scratch.data();
+
+        // Trig for every point against trig for one turn plus copies
+        printBenchmark("Uniform angle",
+            bestSecondsToRun([&]() { evaluateUniform(data, numPoints); }),
+            bestSecondsToRun([&]() {
+                evaluateUniform(data, numPointsPerTurn);
+                replicatePeriod(data, numPointsPerTurn, numPoints, turnOffset);
+            }),
+            numPoints);
 
-        points->InsertNextPoint(x, y, z);
+        // Arc-length resampling is reported on its own, since it dominates both timings
+        if (resample)
+        {
+            printBenchmark("Uniform arc length",
+                bestSecondsToRun([&]() { evaluate(data, numPoints); }),
+                bestSecondsToRun([&]() { evaluateReplicated(data, numPoints); }),
+                numPoints);
+        }
     }
 
     // Create a cell array to store the lines and connect points
     vtkSmartPointer<vtkCellArray> lines = vtkSmartPointer<vtkCellArray>::New();
-    for (unsigned int i = 0; i < numPoints - 1; i++)
+    for (vtkIdType i = 0; i < numStored - 1; i++)
     {
         vtkSmartPointer<vtkLine> line = vtkSmartPointer<vtkLine>::New();
         line->GetPointIds()->SetId(0, i);
@@ -88,8 +380,38 @@ int main()
     spiralPolyData->SetLines(lines);
 
     // Create a mapper and actor for visualization
-    vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputData(spiralPolyData);
+    vtkSmartPointer<vtkMapper> mapper;
+    if (instance)
+    {
+        // One glyph of the stored turn at each turn's offset, drawn by a single actor
+        vtkSmartPointer<vtkPoints> turnOffsets = vtkSmartPointer<vtkPoints>::New();
+        turnOffsets->SetDataTypeToDouble();
+        turnOffsets->SetNumberOfPoints(turns);
+        double* offsets = static_cast<double*>(turnOffsets->GetVoidPointer(0));
+        vtkSMPTools::For(0, turns, [&](vtkIdType k0, vtkIdType k1) {
+            for (vtkIdType k = k0; k < k1; k++)
+            {
+                offsets[3 * k] = 0.0;
+                offsets[3 * k + 1] = 0.0;
+                offsets[3 * k + 2] = k * pitch;
+            }
+        });
+        vtkSmartPointer<vtkPolyData> turnOffsetsPolyData = vtkSmartPointer<vtkPolyData>::New();
+        turnOffsetsPolyData->SetPoints(turnOffsets);
+
+        vtkSmartPointer<vtkGlyph3DMapper> glyphMapper = vtkSmartPointer<vtkGlyph3DMapper>::New();
+        glyphMapper->SetInputData(turnOffsetsPolyData);
+        glyphMapper->SetSourceData(spiralPolyData);
+        glyphMapper->ScalingOff();
+        glyphMapper->OrientOff();
+        mapper = glyphMapper;
+    }
+    else
+    {
+        vtkSmartPointer<vtkPolyDataMapper> polyDataMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+        polyDataMapper->SetInputData(spiralPolyData);
+        mapper = polyDataMapper;
+    }
 
     vtkSmartPointer<vtkActor> actor = vtkSmartPointer<vtkActor>::New();
     actor->SetMapper(mapper);